@@ -7,38 +7,76 @@
 
 #include <iostream>
 #include <iomanip> // Used for table formatting
+#include <sstream> // Used for building the book details as a string
+#include <fstream> // Used for the replication log file
+#include <chrono>  // Used for the replication session ID
+#include <algorithm> // Used for moving search cache entries without copying them
 using namespace std;
 
+// Index of each book field, in the order they are shown in the book tables
+enum BookFieldIndex
+{
+    FIELD_ID,
+    FIELD_ISBN,
+    FIELD_TITLE,
+    FIELD_AUTHOR,
+    FIELD_EDITION,
+    FIELD_PUBLICATION,
+    FIELD_CATEGORY,
+    FIELD_COUNT // Number of book fields
+};
+
+// Struct describing one book field: how it is asked for, shown and validated
+struct BookField
+{
+    const char *label;     // Name used in prompts and in the book details
+    const char *header;    // Column header in the book tables
+    int width;             // Column width in the book tables
+    const char *errorName; // Name used in the "cannot be empty" message
+};
+
+// Book schema, defined once and used to construct, input, show and log books
+// A new field needs an entry here and in BookFieldIndex; only ID and Category have their own input checks
+constexpr BookField bookFields[FIELD_COUNT] = {
+    {"Book ID", "ID", 10, "ID"},
+    {"ISBN", "ISBN", 20, "ISBN"},
+    {"Title", "TITLE", 30, "title"},
+    {"Author", "AUTHOR", 20, "author"},
+    {"Edition", "EDITION", 20, "edition"},
+    {"Publication", "PUBLICATION", 20, "publication"},
+    {"Category", "CATEGORY", 15, "category"},
+};
+
 // Abstract class for Books
 class Book
 {
 private:
-    string id, isbn, title, author, edition, publication, category;
+    string fields[FIELD_COUNT]; // Book details, indexed by BookFieldIndex
 
 public:
     // Default constructor for Book
-    Book() : id(""), isbn(""), title(""), author(""), edition(""), publication(""), category("") {}
+    Book() {}
 
-    // Constructor for Book details
-    Book(string id, string isbn, string title, string author, string edition, string publication, string category)
+    // Constructor for Book details, indexed by BookFieldIndex
+    Book(const string values[FIELD_COUNT])
     {
-        this->id = id;
-        this->isbn = isbn;
-        this->title = title;
-        this->author = author;
-        this->edition = edition;
-        this->publication = publication;
-        this->category = category;
+        for (int field = 0; field < FIELD_COUNT; ++field)
+        {
+            fields[field] = values[field];
+        }
     }
 
-    // Getters for Book details
-    string getID() { return id; }
-    string getISBN() { return isbn; }
-    string getTitle() { return title; }
-    string getAuthor() { return author; }
-    string getEdition() { return edition; }
-    string getPublication() { return publication; }
-    string getCategory() { return category; }
+    virtual ~Book() {} // Virtual destructor so books can be deleted through a Book pointer
+
+    // Getters for Book details (returned by reference so scans over the books array do not copy every field)
+    const string &getField(int field) const { return fields[field]; }
+    const string &getID() const { return fields[FIELD_ID]; }
+    const string &getISBN() const { return fields[FIELD_ISBN]; }
+    const string &getTitle() const { return fields[FIELD_TITLE]; }
+    const string &getAuthor() const { return fields[FIELD_AUTHOR]; }
+    const string &getEdition() const { return fields[FIELD_EDITION]; }
+    const string &getPublication() const { return fields[FIELD_PUBLICATION]; }
+    const string &getCategory() const { return fields[FIELD_CATEGORY]; }
 
     // Virtual functions for Book operations
     virtual void addBook() = 0;
@@ -47,6 +85,24 @@ public:
     virtual void deleteBook(string bookID) = 0;
     virtual void viewByCategory(string category) = 0;
     virtual void viewAllBooks() = 0;
+    virtual void viewBookCounts(string category, string publication) = 0;
+};
+
+// Derived class for a single stored book: holds only the book details, the library-wide
+// counters, cache and replication state stay in the one Library object
+class BookRecord : public Book
+{
+public:
+    BookRecord(const string values[FIELD_COUNT]) : Book(values) {}
+
+    // A single book has no library operations
+    void addBook() override {}
+    void editBook(string) override {}
+    void searchBook(string) override {}
+    void deleteBook(string) override {}
+    void viewByCategory(string) override {}
+    void viewAllBooks() override {}
+    void viewBookCounts(string, string) override {}
 };
 
 // Function to convert string to lowercase
@@ -59,43 +115,34 @@ string toLowerCase(string str)
     return str;
 }
 
-// Derived class Library
-class Library : public Book // Inherits from Book class
+// Function to input a book field, asking again until it is not empty
+string inputField(int field, string prefix) // prefix is "" for new books and "New " when editing
 {
-private:
-    Book *books[10]; // Array to store books
-    int bookCount = 0;
-
-public:
-    Library() {} // Default constructor for Library
+    string value;
+    do
+    {
+        cout << "Enter " << prefix << bookFields[field].label << ": ";
+        getline(cin, value);
 
-    // Constructor for Library details
-    Library(string id, string isbn, string title, string author, string edition, string publication, string category) : Book(id, isbn, title, author, edition, publication, category) {}
+        // Handle empty input
+        if (value.empty())
+        {
+            cout << bookFields[field].label << " cannot be empty! Please enter a valid " << bookFields[field].errorName << "." << endl;
+        }
+    } while (value.empty());
 
-    void addBook() override;
-    void editBook(string bookID) override;
-    void searchBook(string bookID) override;
-    void deleteBook(string bookID) override;
-    void viewByCategory(string category) override;
-    void viewAllBooks() override;
-};
+    return value;
+}
 
-// Add Book Implementation
-void Library::addBook() // Function that belongs to the Library class that performs the overriden addBook operation
+// Function to input a category, asking again until it is Fiction or Non-Fiction
+string inputCategory(string prefix) // prefix is "" for new books and "New " when editing
 {
-    string id, isbn, title, author, edition, publication, category;
+    string category;
     string validCategories[2] = {"fiction", "non-fiction"};
-    bool isValidCategory = false;    // Flag for valid category
-    bool isValidID = false;          // Flag for valid ID
-    bool isValidISBN = false;        // Flag for valid ISBN
-    bool isValidTitle = false;       // Flag for valid title
-    bool isValidAuthor = false;      // Flag for valid author
-    bool isValidEdition = false;     // Flag for valid edition
-    bool isValidPublication = false; // Flag for valid publication
-
+    bool isValidCategory = false; // Flag for valid category
     do
     {
-        cout << "Enter Category [Fiction|Non-Fiction]: ";
+        cout << "Enter " << prefix << "Category [Fiction|Non-Fiction]: ";
         getline(cin, category);
         category = toLowerCase(category);
 
@@ -123,269 +170,430 @@ void Library::addBook() // Function that belongs to the Library class that perfo
         }
     } while (!isValidCategory);
 
-    do
+    return category;
+}
+
+// Function to format the details of a book, used by searchBook and deleteBook
+string formatBookDetails(Book *book)
+{
+    ostringstream details;
+    details << setw(14) << left << bookFields[FIELD_ID].label << ": " << book->getID() << endl;
+    details << "============== BOOK DETAILS ==============" << endl;
+    for (int field = FIELD_ID + 1; field < FIELD_COUNT; ++field) // Loop through the remaining fields
     {
-        cout << "Enter Book ID: ";
-        getline(cin, id);
+        details << setw(14) << left << bookFields[field].label << ": " << book->getField(field) << endl;
+    }
+    details << "==========================================" << endl;
+    return details.str();
+}
 
-        // Handle empty input
-        if (id.empty())
+// The book table functions below show every field except skipField (-1 to show every field)
+
+// Function to get the total width of a book table
+int tableWidth(int skipField)
+{
+    int width = 0;
+    for (int field = 0; field < FIELD_COUNT; ++field)
+    {
+        if (field != skipField)
         {
-            cout << "Book ID cannot be empty! Please enter a valid ID." << endl;
-            isValidID = false;
-            continue; // Skip the rest of the loop and restart the loop
+            width += bookFields[field].width;
         }
+    }
+    return width;
+}
 
-        id = toLowerCase(id);
+// Function to print a title centered in a line of '=' as wide as the book table
+void printTableBanner(string title, int skipField)
+{
+    int padding = tableWidth(skipField) - (int)title.length() - 2; // 2 spaces around the title
+    if (padding < 0)
+    {
+        padding = 0;
+    }
+    cout << string(padding / 2, '=') << " " << title << " " << string(padding - padding / 2, '=') << endl;
+}
 
-        // Check for duplicate ID
-        isValidID = true; // Assume valid until proven otherwise
-        for (int i = 0; i < bookCount; ++i)
+// Function to print the column headers of a book table
+void printTableHeader(int skipField)
+{
+    for (int field = 0; field < FIELD_COUNT; ++field)
+    {
+        if (field != skipField)
         {
-            if (books[i] != nullptr && books[i]->getID() == id) // Checks if books array is not empty and checks for duplicate ID
-            {
-                cout << "Duplicate ID! Book with this ID already exists." << endl;
-                cout << "Please enter a unique ID." << endl;
-                isValidID = false; // Set to false if duplicate is found
-                break;             // Exit the loop if duplicate is found
-            }
+            cout << setw(bookFields[field].width) << left << bookFields[field].header;
         }
+    }
+    cout << endl;
+}
 
-    } while (!isValidID);
-
-    // Input remaining book details
-    do
+// Function to print one book as a table row
+void printTableRow(Book *book, int skipField)
+{
+    for (int field = 0; field < FIELD_COUNT; ++field)
     {
-        cout << "Enter ISBN: ";
-        getline(cin, isbn);
-
-        // Handle empty input
-        if (isbn.empty())
+        if (field != skipField)
         {
-            cout << "ISBN cannot be empty! Please enter a valid ISBN." << endl;
-            isValidISBN = false;
-            continue; // Skip the rest of the loop and restart the loop
+            cout << setw(bookFields[field].width) << left << book->getField(field);
         }
+    }
+    cout << endl;
+}
 
-        isValidISBN = true; // Assume valid until proven otherwise
+// Struct for remembering the details of recently searched books, most recently used first
+struct SearchCache
+{
+    static const int capacity = 5; // Maximum number of cached books
+
+    string ids[capacity];     // Book IDs of the cached books
+    string details[capacity]; // Formatted details for each cached book
+    int size = 0;             // Number of cached books
+    int hits = 0;      // Searches answered from the cache
+    int misses = 0;    // Searches that had to look through the books array
+
+    bool find(const string &id);
+    void add(const string &id, string result);
+    const string &mostRecent() const { return details[0]; } // Details of the last book found or added
+    void remove(const string &id);
+    void moveToFront(int index);
+    void printStats();
+};
 
-    } while (!isValidISBN);
+void SearchCache::moveToFront(int index) // Moves an entry to the front so it is the last to be replaced
+{
+    // Rotating swaps the strings instead of copying them
+    rotate(ids, ids + index, ids + index + 1);
+    rotate(details, details + index, details + index + 1);
+}
 
-    do
-    {
-        cout << "Enter Title: ";
-        getline(cin, title);
+void SearchCache::printStats() // Prints how many searches were answered from the cache
+{
+    int searches = hits + misses;
+    cout << "Cached Books  : " << size << endl;
+    cout << "Hits          : " << hits << endl;
+    cout << "Misses        : " << misses << endl;
+    cout << "Hit Rate      : " << (searches == 0 ? 0 : hits * 100 / searches) << "%" << endl;
+}
 
-        // Handle empty input
-        if (title.empty())
+bool SearchCache::find(const string &id) // Looks for a book in the cache and counts the hit or miss; a hit becomes mostRecent()
+{
+    for (int i = 0; i < size; ++i)
+    {
+        if (ids[i] == id)
         {
-            cout << "Title cannot be empty! Please enter a valid title." << endl;
-            isValidTitle = false;
-            continue; // Skip the rest of the loop and restart the loop
+            moveToFront(i);
+            hits++;
+            return true;
         }
+    }
 
-        isValidTitle = true; // Assume valid until proven otherwise
-    } while (!isValidTitle);
+    misses++;
+    return false;
+}
 
-    do
+void SearchCache::add(const string &id, string result) // Adds a book to the cache, replacing the least recently used one when full
+{
+    if (size < capacity)
     {
-        cout << "Enter Author: ";
-        getline(cin, author);
+        size++;
+    }
+    ids[size - 1] = id; // Put the new entry in the last slot, then move it to the front
+    details[size - 1] = move(result);
+    moveToFront(size - 1);
+}
 
-        // Handle empty input
-        if (author.empty())
+void SearchCache::remove(const string &id) // Removes a book from the cache after it is edited or deleted
+{
+    for (int i = 0; i < size; ++i)
+    {
+        if (ids[i] == id)
         {
-            cout << "Author cannot be empty! Please enter a valid author." << endl;
-            isValidAuthor = false;
-            continue; // Skip the rest of the loop and restart the loop
+            move(ids + i + 1, ids + size, ids + i); // Shift the remaining entries to the left
+            move(details + i + 1, details + size, details + i);
+            size--;
+            return;
         }
+    }
+}
 
-        isValidAuthor = true; // Assume valid until proven otherwise
-    } while (!isValidAuthor);
+// Struct for keeping a running count of books per field value (e.g. books per author)
+// Values are grouped ignoring case, the same way the publication filter matches them
+struct FacetCounter
+{
+    string values[10]; // Distinct field values as first entered, same capacity as the books array
+    string keys[10];   // Lowercase form of each value, used for grouping
+    int counts[10];    // Number of books for each value
+    int size = 0;      // Number of distinct values stored
+
+    void increment(const string &value);
+    void decrement(const string &value);
+    void print(string label);
+};
 
-    do
+void FacetCounter::increment(const string &value) // Adds one book to the count of the given value
+{
+    string key = toLowerCase(value);
+    for (int i = 0; i < size; ++i)
     {
-        cout << "Enter Edition: ";
-        getline(cin, edition);
-
-        // Handle empty input
-        if (edition.empty())
+        if (keys[i] == key) // Value already counted, just increase its count
         {
-            cout << "Edition cannot be empty! Please enter a valid edition." << endl;
-            isValidEdition = false;
-            continue; // Skip the rest of the loop and restart the loop
+            counts[i]++;
+            return;
         }
+    }
 
-        isValidEdition = true; // Assume valid until proven otherwise
-    } while (!isValidEdition);
+    values[size] = value; // New value, add it at the end
+    keys[size] = key;
+    counts[size] = 1;
+    size++;
+}
 
-    do
+void FacetCounter::decrement(const string &value) // Removes one book from the count of the given value
+{
+    string key = toLowerCase(value);
+    for (int i = 0; i < size; ++i)
     {
-        cout << "Enter Publication: ";
-        getline(cin, publication);
-
-        // Handle empty input
-        if (publication.empty())
+        if (keys[i] == key)
         {
-            cout << "Publication cannot be empty! Please enter a valid publication." << endl;
-            isValidPublication = false;
-            continue; // Skip the rest of the loop and restart the loop
-        }
-
-        isValidPublication = true; // Assume valid until proven otherwise
-    } while (!isValidPublication);
-
-    // Create a new book object and store it in the array
-    books[bookCount] = new Library(id, isbn, title, author, edition, publication, category);
-    bookCount++; // Increment book count
+            counts[i]--;
 
-    cout << "Book added successfully!" << endl;
-    system("pause");
+            if (counts[i] == 0) // No more books with this value, remove it from the list
+            {
+                for (int j = i; j < size - 1; ++j)
+                {
+                    values[j] = values[j + 1]; // Shift the remaining values to the left
+                    keys[j] = keys[j + 1];
+                    counts[j] = counts[j + 1];
+                }
+                size--;
+            }
+            return;
+        }
+    }
 }
 
-void Library::editBook(string bookID) // Function that belongs to the Library class that performs the overriden editBook operation
+void FacetCounter::print(string label) // Prints every value with its number of books
 {
-    if (bookCount == 0) // Check if no books are available
+    cout << "------------------- BY " << label << " -------------------" << endl;
+    if (size == 0)
     {
-        cout << "No books available to edit!" << endl;
-        return; // Go back to main menu
+        cout << "(none)" << endl;
     }
 
-    bookID = toLowerCase(bookID);
-    bool found = false;
+    for (int i = 0; i < size; ++i)
+    {
+        cout << setw(40) << left << values[i] << counts[i] << endl;
+    }
+}
 
-    for (int i = 0; i < bookCount; ++i) // Loop through added books
+// Derived class Library
+class Library : public Book // Inherits from Book class
+{
+private:
+    Book *books[10]; // Array to store books
+    int bookCount = 0;
+
+    // Book counts that are updated on every add, edit and delete so reports do not need to go through all books
+    FacetCounter categoryCounts, authorCounts, publicationCounts, editionCounts;
+
+    void countBook(Book *book);   // Adds a book to the counters
+    void uncountBook(Book *book); // Removes a book from the counters
+
+    SearchCache searchCache; // Recently searched books, cleared per book on edit and delete
+
+    // Replication: the primary writes every change to a log file and read-only followers replay it
+    bool readOnly = false;      // Followers cannot add, edit or delete books
+    string logFile;             // Log file shared by the primary and its followers
+    string sessionID;           // First line of the log file, new every time the primary starts
+    long long logPosition = 0;  // Number of bytes of the log file a follower has applied
+    int mutationCount = 0;      // Changes written (primary) or applied (follower)
+
+    int findBook(const string &id);             // Returns the index of a book, or -1 if not found
+    void insertBook(Book *book);                // Adds a book at the end of the books array
+    void replaceBook(int index, Book *book);    // Replaces the book at the given index
+    void removeBook(int index);                 // Deletes the book at the given index
+    void clearBooks();                          // Deletes every book
+    void logMutation(string type, Book *book);  // Primary: writes a change to the log file
+    void applyMutation(const string &line);     // Follower: applies one line of the log file
+    bool readUnapplied(string &header, string &pending); // Follower: reads the session line and the log after what was applied
+
+public:
+    Library() {} // Default constructor for Library
+
+    void addBook() override;
+    void editBook(string bookID) override;
+    void searchBook(string bookID) override;
+    void deleteBook(string bookID) override;
+    void viewByCategory(string category) override;
+    void viewAllBooks() override;
+    void viewBookCounts(string category, string publication) override;
+
+    // Replication operations
+    void startPrimary(string file);
+    void startFollower(string file);
+    void syncFromLog();
+    void viewReplicationStatus();
+
+    void viewSearchCacheStats();
+    bool isReadOnly() { return readOnly; }
+};
+
+void Library::countBook(Book *book)
+{
+    categoryCounts.increment(book->getCategory());
+    authorCounts.increment(book->getAuthor());
+    publicationCounts.increment(book->getPublication());
+    editionCounts.increment(book->getEdition());
+}
+
+void Library::uncountBook(Book *book)
+{
+    categoryCounts.decrement(book->getCategory());
+    authorCounts.decrement(book->getAuthor());
+    publicationCounts.decrement(book->getPublication());
+    editionCounts.decrement(book->getEdition());
+}
+
+int Library::findBook(const string &id)
+{
+    for (int i = 0; i < bookCount; ++i)
     {
-        if (books[i] != nullptr && books[i]->getID() == bookID) // Checks if books array is not empty and checks for book ID
+        if (books[i] != nullptr && books[i]->getID() == id)
         {
-            string newCategory, newISBN, newTitle, newAuthor, newEdition, newPublication;
-            string validCategories[2] = {"fiction", "non-fiction"};
-            bool isValidCategory = false;
-            bool isValidISBN = false;
-            bool isValidTitle = false;
-            bool isValidAuthor = false;
-            bool isValidEdition = false;
-            bool isValidPublication = false;
-
-            // Get new category
-            do
-            {
-                cout << "Enter New Category [Fiction|Non-Fiction]: ";
-                getline(cin, newCategory);
-                newCategory = toLowerCase(newCategory);
+            return i;
+        }
+    }
+    return -1;
+}
 
-                for (string valid : validCategories) // Loop through valid categories
-                {
-                    if (newCategory == valid) // Check if input category is valid
-                    {
-                        if (newCategory == "fiction")
-                        {
-                            newCategory = "Fiction"; // Set category to "Fiction" if input is "fiction"
-                        }
-                        else
-                        {
-                            newCategory = "Non-Fiction"; // Set category to "Non-Fiction" if input is "non-fiction"
-                        }
-                        isValidCategory = true;
-                        break;
-                    }
-                }
+void Library::insertBook(Book *book)
+{
+    books[bookCount] = book;     // Store the book at the end of the array
+    countBook(books[bookCount]); // Update the book counts
+    bookCount++;                 // Increment book count
+}
 
-                if (!isValidCategory)
-                {
-                    cout << "Category not found! Please enter 'Fiction' or 'Non-Fiction'." << endl;
-                }
-            } while (!isValidCategory);
+void Library::replaceBook(int index, Book *book)
+{
+    uncountBook(books[index]);                 // Remove old details from the book counts
+    searchCache.remove(books[index]->getID()); // Old details are no longer valid
+    delete books[index];                       // Delete old book object
+    books[index] = book;
+    countBook(books[index]); // Add new details to the book counts
+}
 
-            // Get other book details
-            do
-            {
-                cout << "Enter New ISBN: ";
-                getline(cin, newISBN);
+void Library::removeBook(int index)
+{
+    uncountBook(books[index]);                 // Remove book from the book counts
+    searchCache.remove(books[index]->getID()); // Remove book from the search cache
+    delete books[index];                       // delete book and free memory
+    books[index] = nullptr;                    // Set the pointer to null
 
-                // Handle empty input
-                if (newISBN.empty())
-                {
-                    cout << "ISBN cannot be empty! Please enter a valid ISBN." << endl;
-                    isValidISBN = false;
-                    continue; // Skip the rest of the loop and restart the loop
-                }
+    // Shift remaining books to fill the gap
+    for (int j = index; j < bookCount - 1; ++j)
+    {
+        books[j] = books[j + 1]; // Shift elements to the left by shifting the values of the next element to the current element
+    }
 
-                isValidISBN = true; // Assume valid until proven otherwise
+    books[bookCount - 1] = nullptr; // Set the last element to nullptr
+    bookCount--;                    // Decrease book count
+}
 
-            } while (!isValidISBN);
+void Library::clearBooks()
+{
+    while (bookCount > 0)
+    {
+        removeBook(bookCount - 1); // Remove from the end so nothing needs to be shifted
+    }
+}
 
-            do
-            {
-                cout << "Enter New Title: ";
-                getline(cin, newTitle);
+// Add Book Implementation
+void Library::addBook() // Function that belongs to the Library class that performs the overriden addBook operation
+{
+    if (readOnly) // Followers only serve reads
+    {
+        cout << "This front desk is read-only! Please add books at the primary front desk." << endl;
+        return; // Go back to main menu
+    }
 
-                // Handle empty input
-                if (newTitle.empty())
-                {
-                    cout << "Title cannot be empty! Please enter a valid title." << endl;
-                    isValidTitle = false;
-                    continue; // Skip the rest of the loop and restart the loop
-                }
+    string values[FIELD_COUNT]; // New book details, indexed by BookFieldIndex
+    string &id = values[FIELD_ID];
+    bool isValidID = false; // Flag for valid ID
 
-                isValidTitle = true; // Assume valid until proven otherwise
+    values[FIELD_CATEGORY] = inputCategory("");
 
-            } while (!isValidTitle);
+    do
+    {
+        id = toLowerCase(inputField(FIELD_ID, ""));
 
-            do
+        // Check for duplicate ID
+        isValidID = true; // Assume valid until proven otherwise
+        for (int i = 0; i < bookCount; ++i)
+        {
+            if (books[i] != nullptr && books[i]->getID() == id) // Checks if books array is not empty and checks for duplicate ID
             {
-                cout << "Enter New Author: ";
-                getline(cin, newAuthor);
+                cout << "Duplicate ID! Book with this ID already exists." << endl;
+                cout << "Please enter a unique ID." << endl;
+                isValidID = false; // Set to false if duplicate is found
+                break;             // Exit the loop if duplicate is found
+            }
+        }
 
-                // Handle empty input
-                if (newAuthor.empty())
-                {
-                    cout << "Author cannot be empty! Please enter a valid author." << endl;
-                    isValidAuthor = false;
-                    continue; // Skip the rest of the loop and restart the loop
-                }
+    } while (!isValidID);
 
-                isValidAuthor = true; // Assume valid until proven otherwise
+    // Input remaining book details
+    for (int field = 0; field < FIELD_COUNT; ++field)
+    {
+        if (field != FIELD_ID && field != FIELD_CATEGORY) // ID and category were asked for above
+        {
+            values[field] = inputField(field, "");
+        }
+    }
 
-            } while (!isValidAuthor);
+    // Create a new book object and store it in the array
+    insertBook(new BookRecord(values));
+    logMutation("ADD", books[bookCount - 1]); // Send the new book to the followers
 
-            do
-            {
-                cout << "Enter New Edition: ";
-                getline(cin, newEdition);
+    cout << "Book added successfully!" << endl;
+    system("pause");
+}
 
-                // Handle empty input
-                if (newEdition.empty())
-                {
-                    cout << "Edition cannot be empty! Please enter a valid edition." << endl;
-                    isValidEdition = false;
-                    continue; // Skip the rest of the loop and restart the loop
-                }
+void Library::editBook(string bookID) // Function that belongs to the Library class that performs the overriden editBook operation
+{
+    if (readOnly) // Followers only serve reads
+    {
+        cout << "This front desk is read-only! Please edit books at the primary front desk." << endl;
+        return; // Go back to main menu
+    }
 
-                isValidEdition = true; // Assume valid until proven otherwise
+    if (bookCount == 0) // Check if no books are available
+    {
+        cout << "No books available to edit!" << endl;
+        return; // Go back to main menu
+    }
 
-            } while (!isValidEdition);
+    bookID = toLowerCase(bookID);
+    bool found = false;
 
-            do
+    for (int i = 0; i < bookCount; ++i) // Loop through added books
+    {
+        if (books[i] != nullptr && books[i]->getID() == bookID) // Checks if books array is not empty and checks for book ID
+        {
+            // Get new category and other book details
+            string newValues[FIELD_COUNT];
+            newValues[FIELD_ID] = bookID; // Keep original ID
+            newValues[FIELD_CATEGORY] = inputCategory("New ");
+            for (int field = 0; field < FIELD_COUNT; ++field)
             {
-                cout << "Enter New Publication: ";
-                getline(cin, newPublication);
-
-                // Handle empty input
-                if (newPublication.empty())
+                if (field != FIELD_ID && field != FIELD_CATEGORY)
                 {
-                    cout << "Publication cannot be empty! Please enter a valid publication." << endl;
-                    isValidPublication = false;
-                    continue; // Skip the rest of the loop and restart the loop
+                    newValues[field] = inputField(field, "New ");
                 }
-
-                isValidPublication = true; // Assume valid until proven otherwise
-
-            } while (!isValidPublication);
+            }
 
             // Update book details
-            delete books[i];                                                                                       // Delete old book object
-            books[i] = new Library(bookID, newISBN, newTitle, newAuthor, newEdition, newPublication, newCategory); // Keep original ID and replace the other book details
+            replaceBook(i, new BookRecord(newValues)); // Replace the other book details
+            logMutation("EDIT", books[i]);             // Send the new details to the followers
             cout << "Book updated successfully!" << endl;
             found = true;
             break;
@@ -411,19 +619,18 @@ void Library::searchBook(string bookID) // Function that belongs to the Library
     bookID = toLowerCase(bookID);
     bool found = false;
 
-    for (int i = 0; i < bookCount; ++i) // Loop through added books
+    if (searchCache.find(bookID)) // Check recently searched books first
+    {
+        cout << searchCache.mostRecent();
+        found = true;
+    }
+
+    for (int i = 0; i < bookCount && !found; ++i) // Loop through added books
     {
         if (books[i] != nullptr && books[i]->getID() == bookID) // Checks if books array is not empty and checks for book ID
         {
-            cout << "Book ID       : " << books[i]->getID() << endl;
-            cout << "============== BOOK DETAILS ==============" << endl;
-            cout << "ISBN          : " << books[i]->getISBN() << endl;
-            cout << "Title         : " << books[i]->getTitle() << endl;
-            cout << "Author        : " << books[i]->getAuthor() << endl;
-            cout << "Edition       : " << books[i]->getEdition() << endl;
-            cout << "Publication   : " << books[i]->getPublication() << endl;
-            cout << "Category      : " << books[i]->getCategory() << endl;
-            cout << "==========================================" << endl;
+            searchCache.add(bookID, formatBookDetails(books[i])); // Remember the details for the next search
+            cout << searchCache.mostRecent();
             found = true;
             break;
         }
@@ -439,6 +646,12 @@ void Library::searchBook(string bookID) // Function that belongs to the Library
 
 void Library::deleteBook(string bookID) // Function that belongs to the Library class that performs the overriden deleteBook operation
 {
+    if (readOnly) // Followers only serve reads
+    {
+        cout << "This front desk is read-only! Please delete books at the primary front desk." << endl;
+        return; // Go back to main menu
+    }
+
     if (bookCount == 0) // Check if no books are available
     {
         cout << "No books available to delete!" << endl;
@@ -455,15 +668,7 @@ void Library::deleteBook(string bookID) // Function that belongs to the Library
             string confirmation;
             do
             {
-                cout << "Book ID       : " << books[i]->getID() << endl;
-                cout << "============== BOOK DETAILS ==============" << endl;
-                cout << "ISBN          : " << books[i]->getISBN() << endl;
-                cout << "Title         : " << books[i]->getTitle() << endl;
-                cout << "Author        : " << books[i]->getAuthor() << endl;
-                cout << "Edition       : " << books[i]->getEdition() << endl;
-                cout << "Publication   : " << books[i]->getPublication() << endl;
-                cout << "Category      : " << books[i]->getCategory() << endl;
-                cout << "==========================================" << endl;
+                cout << formatBookDetails(books[i]);
 
                 cout << "Do you want to delete this book? [Y/N]: ";
                 getline(cin, confirmation);
@@ -478,17 +683,8 @@ void Library::deleteBook(string bookID) // Function that belongs to the Library
 
             if (confirmation == "y")
             {
-                delete books[i];    // delete book and free memory
-                books[i] = nullptr; // Set the pointer to null
-
-                // Shift remaining books to fill the gap
-                for (int j = i; j < bookCount - 1; ++j)
-                {
-                    books[j] = books[j + 1]; // Shift elements to the left by shifting the values of the next element to the current element
-                }
-
-                books[bookCount - 1] = nullptr; // Set the last element to nullptr
-                bookCount--;                    // Decrease book count
+                logMutation("DELETE", books[i]); // Send the deletion to the followers
+                removeBook(i);
 
                 cout << "Book deleted successfully!" << endl;
             }
@@ -520,28 +716,20 @@ void Library::viewByCategory(string category) // Function that belongs to the Li
     }
 
     bool found = false;
+    int matchCount = 0; // Number of books listed under the category
 
     cout << endl;
-    cout << "==================================================== " << category << " BOOKS ====================================================" << endl;
-    cout << setw(10) << left << "ID"
-         << setw(20) << "ISBN"
-         << setw(30) << "TITLE"
-         << setw(20) << "AUTHOR"
-         << setw(20) << "EDITION"
-         << setw(20) << "PUBLICATION" << endl;
-    cout << string(123, '-') << endl;
+    printTableBanner(category + " BOOKS", FIELD_CATEGORY);
+    printTableHeader(FIELD_CATEGORY); // Every field except the category
+    cout << string(tableWidth(FIELD_CATEGORY), '-') << endl;
 
     for (int i = 0; i < bookCount; ++i)
     {
         if (books[i] != nullptr && books[i]->getCategory() == category)
         {
-            cout << setw(10) << left << books[i]->getID()
-                 << setw(20) << books[i]->getISBN()
-                 << setw(30) << books[i]->getTitle()
-                 << setw(20) << books[i]->getAuthor()
-                 << setw(20) << books[i]->getEdition()
-                 << setw(20) << books[i]->getPublication() << endl;
+            printTableRow(books[i], FIELD_CATEGORY);
             found = true;
+            matchCount++;
         }
     }
 
@@ -549,7 +737,12 @@ void Library::viewByCategory(string category) // Function that belongs to the Li
     {
         cout << "No books found under the category: " << category << endl;
     }
-    cout << "===========================================================================================================================" << endl;
+    else
+    {
+        cout << string(tableWidth(FIELD_CATEGORY), '-') << endl;
+        cout << "Total " << category << " Books: " << matchCount << endl;
+    }
+    cout << string(tableWidth(FIELD_CATEGORY), '=') << endl;
     system("pause");
 }
 
@@ -563,36 +756,357 @@ void Library::viewAllBooks() // Function that belongs to the Library class that
     }
 
     cout << endl;
-    cout << "============================================================ LIBRARY BOOKS ============================================================" << endl;
-    cout << setw(10) << left << "ID"
-         << setw(20) << "ISBN"
-         << setw(30) << "TITLE"
-         << setw(20) << "AUTHOR"
-         << setw(20) << "EDITION"
-         << setw(20) << "PUBLICATION"
-         << setw(15) << "CATEGORY" << endl;
-    cout << string(135, '-') << endl;
+    printTableBanner("LIBRARY BOOKS", -1);
+    printTableHeader(-1); // Every field
+    cout << string(tableWidth(-1), '-') << endl;
 
     for (int i = 0; i < bookCount; ++i)
     {
         if (books[i] != nullptr)
         {
-            cout << setw(10) << left << books[i]->getID()
-                 << setw(20) << books[i]->getISBN()
-                 << setw(30) << books[i]->getTitle()
-                 << setw(20) << books[i]->getAuthor()
-                 << setw(20) << books[i]->getEdition()
-                 << setw(20) << books[i]->getPublication()
-                 << setw(15) << books[i]->getCategory() << endl;
+            printTableRow(books[i], -1);
+        }
+    }
+    cout << string(tableWidth(-1), '=') << endl;
+    system("pause");
+}
+
+void Library::viewBookCounts(string category, string publication) // Function that belongs to the Library class that performs the overriden viewBookCounts operation
+{
+    if (bookCount == 0) // Check if no books are available
+    {
+        cout << "No books available to count!" << endl
+             << endl;
+        return; // Go back to main menu
+    }
+
+    // Use the running counters when no filter is given, otherwise count only the books that match the filter
+    FacetCounter filteredCategories, filteredAuthors, filteredPublications, filteredEditions;
+    FacetCounter *byCategory = &categoryCounts;
+    FacetCounter *byAuthor = &authorCounts;
+    FacetCounter *byPublication = &publicationCounts;
+    FacetCounter *byEdition = &editionCounts;
+    int total = bookCount;
+
+    if (!category.empty() || !publication.empty())
+    {
+        string publicationFilter = toLowerCase(publication); // Convert once instead of on every book
+        total = 0;
+        for (int i = 0; i < bookCount; ++i)
+        {
+            if (books[i] == nullptr)
+            {
+                continue;
+            }
+            if (!category.empty() && books[i]->getCategory() != category) // Skip books from other categories
+            {
+                continue;
+            }
+            if (!publication.empty() && toLowerCase(books[i]->getPublication()) != publicationFilter) // Skip books from other publications
+            {
+                continue;
+            }
+
+            filteredCategories.increment(books[i]->getCategory());
+            filteredAuthors.increment(books[i]->getAuthor());
+            filteredPublications.increment(books[i]->getPublication());
+            filteredEditions.increment(books[i]->getEdition());
+            total++;
+        }
+
+        byCategory = &filteredCategories;
+        byAuthor = &filteredAuthors;
+        byPublication = &filteredPublications;
+        byEdition = &filteredEditions;
+    }
+
+    cout << endl;
+    cout << "==================== BOOK COUNTS ====================" << endl;
+    cout << "Category      : " << (category.empty() ? "All" : category) << endl;
+    cout << "Publication   : " << (publication.empty() ? "All" : publication) << endl;
+    cout << "Total Books   : " << total << endl;
+    byCategory->print("CATEGORY");
+    byAuthor->print("AUTHOR");
+    byPublication->print("PUBLICATION");
+    byEdition->print("EDITION");
+    cout << "=====================================================" << endl;
+    system("pause");
+}
+
+// Start the primary front desk: clears the log file and writes a new session ID as its first line,
+// so followers know to start over from an empty library
+void Library::startPrimary(string file)
+{
+    logFile = file;
+    readOnly = false;
+    sessionID = "SESSION\t" + to_string(chrono::system_clock::now().time_since_epoch().count());
+    ofstream log(logFile, ios::trunc | ios::binary);
+    if (!log)
+    {
+        cout << "Could not open the log file " << logFile << "! Changes will not be sent to followers." << endl;
+        logFile = "";
+        return;
+    }
+    log << sessionID << '\n';
+}
+
+// Start a read-only follower front desk that replays the log file of the primary
+void Library::startFollower(string file)
+{
+    logFile = file;
+    readOnly = true;
+    syncFromLog(); // Catch up on every change made before this follower started
+}
+
+// Writes one change as a line: the change type followed by every book field, separated by tabs
+// Tabs, newlines and backslashes inside a field are written with a backslash in front (\t, \n and a double backslash)
+void Library::logMutation(string type, Book *book)
+{
+    if (logFile.empty())
+    {
+        return; // Replication is off
+    }
+
+    ofstream log(logFile, ios::app | ios::binary);
+    log << type;
+    for (int field = 0; field < FIELD_COUNT; ++field)
+    {
+        log << '\t';
+        for (char c : book->getField(field))
+        {
+            if (c == '\t')
+            {
+                log << "\\t";
+            }
+            else if (c == '\n')
+            {
+                log << "\\n";
+            }
+            else if (c == '\\')
+            {
+                log << "\\\\";
+            }
+            else
+            {
+                log << c;
+            }
+        }
+    }
+    log << '\n';
+    log.flush(); // Make the change visible to followers right away
+    mutationCount++;
+}
+
+// Applies one line of the log file written by logMutation
+void Library::applyMutation(const string &line)
+{
+    string type, fields[FIELD_COUNT];
+    int field = -1;       // -1 while reading the change type
+    bool escaped = false; // True right after a backslash
+    for (char c : line)
+    {
+        if (escaped) // Undo the escaping done by logMutation
+        {
+            if (c == 't')
+            {
+                c = '\t';
+            }
+            else if (c == 'n')
+            {
+                c = '\n';
+            }
+            escaped = false;
+        }
+        else if (c == '\\')
+        {
+            escaped = true;
+            continue;
+        }
+        else if (c == '\t')
+        {
+            field++;
+            continue;
+        }
+
+        if (field < 0)
+        {
+            type += c;
+        }
+        else if (field < FIELD_COUNT)
+        {
+            fields[field] += c;
         }
     }
-    cout << "=======================================================================================================================================" << endl;
+
+    if (field != FIELD_COUNT - 1) // Wrong number of fields, so this is not a line written by logMutation
+    {
+        return;
+    }
+
+    int index = findBook(fields[FIELD_ID]);
+    if (type == "DELETE" && index != -1)
+    {
+        removeBook(index);
+    }
+    else if ((type == "ADD" && index == -1 && bookCount < 10) || (type == "EDIT" && index != -1))
+    {
+        Book *book = new BookRecord(fields);
+        if (type == "ADD")
+        {
+            insertBook(book);
+        }
+        else
+        {
+            replaceBook(index, book);
+        }
+    }
+    else
+    {
+        return; // Nothing to apply, so do not count it
+    }
+    mutationCount++;
+}
+
+// Follower: reads the session line of the log file and everything after the part already applied
+// Returns false when there is no log file or no complete session line yet (the primary is still starting)
+bool Library::readUnapplied(string &header, string &pending)
+{
+    if (!readOnly || logFile.empty())
+    {
+        return false; // Only followers read the log file
+    }
+
+    ifstream log(logFile, ios::binary);
+    if (!log)
+    {
+        return false; // The primary has not started yet
+    }
+
+    getline(log, header);
+    if (log.eof()) // No complete first line yet
+    {
+        return false;
+    }
+
+    log.seekg(0, ios::end);
+    long long logSize = log.tellg();
+    long long start = logPosition;
+    if (header != sessionID || logSize < logPosition) // New session, so everything after the session line is unapplied
+    {
+        start = header.length() + 1;
+    }
+
+    pending.assign(logSize - start, '\0');
+    log.seekg(start);
+    log.read(&pending[0], pending.size());
+    return true;
+}
+
+// Follower: applies every complete line the primary wrote since the last sync
+void Library::syncFromLog()
+{
+    string header, pending;
+    if (!readUnapplied(header, pending))
+    {
+        return;
+    }
+
+    // A different session ID on the first line means the primary restarted
+    if (header != sessionID || logPosition < (long long)header.length() + 1)
+    {
+        clearBooks(); // Start over from an empty library
+        sessionID = header;
+        logPosition = header.length() + 1; // Start reading after the session line
+        mutationCount = 0;
+    }
+
+    size_t lineStart = 0;
+    size_t lineEnd = pending.find('\n');
+    while (lineEnd != string::npos) // A line without '\n' is still being written, so leave it for the next sync
+    {
+        applyMutation(pending.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+        lineEnd = pending.find('\n', lineStart);
+    }
+    logPosition += lineStart;
+}
+
+void Library::viewReplicationStatus()
+{
+    cout << endl;
+    cout << "================= REPLICATION STATUS =================" << endl;
+    cout << "Role          : " << (readOnly ? "Follower (read-only)" : (logFile.empty() ? "Standalone (not replicating)" : "Primary")) << endl;
+    cout << "Log File      : " << (logFile.empty() ? "(none)" : logFile) << endl;
+    if (readOnly)
+    {
+        // Measure how far behind the primary this follower is before catching up
+        string header, pending;
+        int unreadLines = 0;
+        if (!readUnapplied(header, pending))
+        {
+            pending = "";
+        }
+        for (char c : pending)
+        {
+            if (c == '\n') // Only complete lines count, a partly written line is not a change yet
+            {
+                unreadLines++;
+            }
+        }
+        cout << "Lag           : " << unreadLines << " unread log lines (" << pending.size() << " bytes)" << endl;
+
+        syncFromLog();
+        cout << "Applied       : " << mutationCount << " changes" << endl;
+    }
+    else
+    {
+        cout << "Sent          : " << mutationCount << " changes" << endl;
+    }
+    cout << "Books         : " << bookCount << endl;
+    cout << "======================================================" << endl;
+    system("pause");
+}
+
+void Library::viewSearchCacheStats()
+{
+    cout << endl;
+    cout << "================= SEARCH CACHE STATS =================" << endl;
+    searchCache.printStats();
+    cout << "======================================================" << endl;
     system("pause");
 }
 
-int main()
+// Usage: LibraryManagementSystem [--primary <log file> | --follower <log file>]
+// Without an option the program runs on its own and does not write a log file
+int main(int argc, char *argv[])
 {
     Library lib; // Create an object of Library class
+    string role, logFile;
+    for (int i = 1; i < argc; ++i)
+    {
+        string option = argv[i];
+        if ((option == "--primary" || option == "--follower") && role.empty() && i + 1 < argc)
+        {
+            role = option;
+            logFile = argv[++i]; // The log file comes right after the option
+        }
+        else
+        {
+            cout << "Invalid option: " << option << endl;
+            cout << "Usage: " << argv[0] << " [--primary <log file> | --follower <log file>]" << endl;
+            return 1;
+        }
+    }
+
+    if (role == "--primary")
+    {
+        lib.startPrimary(logFile);
+    }
+    else if (role == "--follower")
+    {
+        lib.startFollower(logFile);
+    }
+
     bool running = true;
     while (running)
     {
@@ -600,7 +1114,7 @@ int main()
         int viewMenu;
 
         cout << endl;
-        cout << "Welcome to Library Management System!" << endl;
+        cout << "Welcome to Library Management System!" << (lib.isReadOnly() ? " (Read-Only Front Desk)" : "") << endl;
         cout << "======================== MENU ========================" << endl;
         cout << "1. Add Book" << endl;
         cout << "2. Edit Book" << endl;
@@ -608,9 +1122,12 @@ int main()
         cout << "4. Delete Book" << endl;
         cout << "5. View Books by Category" << endl;
         cout << "6. View All Books" << endl;
-        cout << "7. Exit" << endl;
+        cout << "7. View Book Counts" << endl;
+        cout << "8. View Replication Status" << endl;
+        cout << "9. View Search Cache Stats" << endl;
+        cout << "10. Exit" << endl;
         cout << "======================================================" << endl;
-        cout << "View [1|2|3|4|5|6|7]: ";
+        cout << "View [1|2|3|4|5|6|7|8|9|10]: ";
         getline(cin, viewMN);
 
         bool isValid = true;
@@ -625,25 +1142,30 @@ int main()
 
         if (!isValid || viewMN.empty())
         {
-            cout << "Invalid Input! Please enter 1, 2, 3, 4, 5, 6, or 7 only." << endl
+            cout << "Invalid Input! Please enter 1, 2, 3, 4, 5, 6, 7, 8, 9, or 10 only." << endl
                  << endl;
             continue; // Skips the rest of the for loop and restarts the while loop
         }
 
         viewMenu = stoi(viewMN);
 
-        if (viewMenu < 1 || viewMenu > 7)
+        if (viewMenu < 1 || viewMenu > 10)
         {
-            cout << "Invalid Choice! Please choose from 1, 2, 3, 4, 5, 6, or 7 only.." << endl
+            cout << "Invalid Choice! Please choose from 1, 2, 3, 4, 5, 6, 7, 8, 9, or 10 only.." << endl
                  << endl;
         }
-        else if (viewMenu == 7)
+        else if (viewMenu == 10)
         {
             cout << "Thank you for visiting our Library Management System! Exiting program..." << endl;
             running = false;
             break; // Stops the program
         }
 
+        if (viewMenu != 8) // The replication status measures the lag before syncing itself
+        {
+            lib.syncFromLog(); // Followers pick up the latest changes from the primary before every action
+        }
+
         switch (viewMenu)
         {
         case 1:
@@ -703,47 +1225,72 @@ int main()
         {
             cout << endl
                  << "====================== VIEW BOOKS BY CATEGORY ======================" << endl;
-            string category;
-            string validCategories[2] = {"fiction", "non-fiction"};
+            string category = inputCategory("");
+            cout << "====================================================================" << endl;
+            lib.viewByCategory(category); // Call viewByCategory() function
+
+            break;
+        }
+
+        case 6:
+        {
+            lib.viewAllBooks(); // Call the viewAllBooks() function
+
+            break;
+        }
+
+        case 7:
+        {
+            cout << endl
+                 << "===================== VIEW BOOK COUNTS =====================" << endl;
+            string category, publication;
             bool isValidCategory = false; // Flag for valid category
             do
             {
-                cout << "Enter Category [Fiction|Non-Fiction]: ";
+                cout << "Enter Category [Fiction|Non-Fiction|All]: ";
                 getline(cin, category);
                 category = toLowerCase(category);
 
                 // Validate category
-                for (string valid : validCategories) // Loop through valid categories
+                if (category == "fiction")
                 {
-                    if (category == valid) // Check if input category is valid
-                    {
-                        if(category == "fiction")
-                        {
-                            category = "Fiction"; // Set category to "Fiction" if input is "fiction"
-                        }
-                        else
-                        {
-                            category = "Non-Fiction"; // Set category to "Non-Fiction" if input is "non-fiction"
-                        }
-                        isValidCategory = true;
-                        break;
-                    }
+                    category = "Fiction";
+                    isValidCategory = true;
                 }
-
-                if (!isValidCategory) // Check if input category is invalid
+                else if (category == "non-fiction")
+                {
+                    category = "Non-Fiction";
+                    isValidCategory = true;
+                }
+                else if (category == "all" || category.empty())
+                {
+                    category = ""; // Empty category means no filter
+                    isValidCategory = true;
+                }
+                else
                 {
-                    cout << "Category not found! Please enter 'Fiction' or 'Non-Fiction'." << endl;
+                    cout << "Category not found! Please enter 'Fiction', 'Non-Fiction' or 'All'." << endl;
                 }
             } while (!isValidCategory);
-            cout << "====================================================================" << endl;
-            lib.viewByCategory(category); // Call viewByCategory() function
+
+            cout << "Enter Publication (leave blank for all): ";
+            getline(cin, publication);
+            cout << "============================================================" << endl;
+            lib.viewBookCounts(category, publication); // Call the viewBookCounts() function
 
             break;
         }
 
-        case 6:
+        case 8:
         {
-            lib.viewAllBooks(); // Call the viewAllBooks() function
+            lib.viewReplicationStatus(); // Call the viewReplicationStatus() function
+
+            break;
+        }
+
+        case 9:
+        {
+            lib.viewSearchCacheStats(); // Call the viewSearchCacheStats() function
 
             break;
         }
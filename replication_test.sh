@@ -0,0 +1,156 @@
+#!/usr/bin/env bash
+# Replication test for the Library Management System
+#
+# Runs one primary and two follower front desks on this machine and checks that the followers
+# end up with the same books as the primary after adds, edits and deletes under load, a primary
+# restart, and a log line that is only partly written.
+#
+# Usage: ./replication_test.sh
+# Needs bash, g++ and mkfifo (Linux, macOS or WSL). Exits with 0 when every check passes.
+
+src="$(cd "$(dirname "$0")" && pwd)"
+work="$(mktemp -d)"
+log="$work/library_log.txt"
+failures=0
+
+cleanup()
+{
+    kill $(jobs -p) 2>/dev/null
+    rm -rf "$work"
+}
+trap cleanup EXIT
+
+# Compile the program
+g++ -std=c++17 -o "$work/lms" "$src/LibraryManagementSystem.cpp" || exit 1
+
+# Prints the rows of the last LIBRARY BOOKS table in an output file
+last_table()
+{
+    awk '/ LIBRARY BOOKS /{rows=""; inTable=1; next}
+         inTable && /^=+$/{inTable=0; next}
+         inTable{rows=rows $0 "\n"}
+         END{printf "%s", rows}' "$1"
+}
+
+check()
+{
+    if [ "$2" = "ok" ]; then
+        echo "PASS: $1"
+    else
+        echo "FAIL: $1"
+        failures=$((failures + 1))
+    fi
+}
+
+# Checks that both followers show the same books as the primary
+check_same_books()
+{
+    local expected
+    expected="$(last_table "$work/primary.out")"
+    for f in 1 2; do
+        if [ -n "$expected" ] && [ "$(last_table "$work/follower$f.out")" = "$expected" ]; then
+            check "$1 (follower $f)" ok
+        else
+            check "$1 (follower $f)" failed
+        fi
+    done
+}
+
+# Lets every desk finish the input it was sent
+settle()
+{
+    sleep 1
+}
+
+# Input for adding a book: category, ID, ISBN, title, author, edition, publication
+add_book()
+{
+    printf '1\n%s\n%s\nisbn-%s\n%s\n%s\n%s\n%s\n' "$1" "$2" "$2" "$3" "$4" "$5" "$6"
+}
+
+start_primary()
+{
+    timeout 60 "$work/lms" --primary "$log" < "$work/primary.in" >> "$work/primary.out" 2>/dev/null &
+    primary=$!
+}
+
+mkfifo "$work/primary.in" "$work/follower1.in" "$work/follower2.in"
+
+# Followers start before the primary, so they must cope with a missing log file
+timeout 60 "$work/lms" --follower "$log" < "$work/follower1.in" > "$work/follower1.out" 2>/dev/null &
+timeout 60 "$work/lms" --follower "$log" < "$work/follower2.in" > "$work/follower2.out" 2>/dev/null &
+exec 4> "$work/follower1.in" 5> "$work/follower2.in"
+start_primary
+exec 3> "$work/primary.in"
+
+# Session 1: add books while both followers keep reading
+for i in 1 2 3 4 5 6 7 8; do
+    add_book fiction "a$i" "Title $i" "Author $((i % 3))" 1st "Publisher $((i % 2))" >&3
+    printf '6\n' >&4
+    printf '6\n' >&5
+done
+printf '2\na2\nnon-fiction\nisbn-edited\nEdited\tTitle\nNew Author\n2nd\nNew Publisher\n' >&3 # Title with a tab
+printf '4\na3\ny\n' >&3
+printf '6\n' >&3
+settle
+printf '6\n' >&4
+printf '6\n' >&5
+settle
+check_same_books "add, edit and delete under load"
+
+printf '1\n' >&4
+settle
+grep -q "read-only" "$work/follower1.out" && check "follower refuses to add books" ok || check "follower refuses to add books" failed
+
+# Session 2: restart the primary and write more than session 1 before the followers sync again
+printf '10\n' >&3
+exec 3>&-
+wait $primary
+start_primary
+exec 3> "$work/primary.in"
+for i in 1 2 3 4 5; do
+    add_book non-fiction "b$i" "A much longer title for book $i so the new log grows past the old one $i $i $i $i" "Author B$i" 3rd Publisher >&3
+done
+printf '6\n' >&3
+settle
+printf '6\n' >&4
+printf '6\n' >&5
+settle
+check_same_books "followers start over after a primary restart"
+
+# A line the primary has only partly written must wait until it is complete
+printf 'ADD\tp1\tisbn-p1\tPartial' >> "$log"
+printf '6\n' >&4
+printf '6\n' >&5
+settle
+check_same_books "partly written line is not applied"
+
+# Complete the line and add an EDIT for a book that does not exist, which followers must ignore
+printf '\tAuthor P\t1st\tPublisher\tFiction\n' >> "$log"
+printf 'EDIT\tzz\tisbn-zz\tTitle\tAuthor\t1st\tPublisher\tFiction\n' >> "$log"
+
+# Follower 1 has not read these lines yet, so its status must show them as lag before applying them
+printf '8\n' >&4
+settle
+grep -q "Lag           : 2 unread log lines" "$work/follower1.out" && check "replication status measures lag before syncing" ok || check "replication status measures lag before syncing" failed
+grep -q "Applied       : 6 changes" "$work/follower1.out" && check "replication status counts only applied changes" ok || check "replication status counts only applied changes" failed
+
+printf '6\n' >&4
+printf '6\n' >&5
+settle
+for f in 1 2; do
+    last_table "$work/follower$f.out" | grep -q "^p1 " && check "completed line is applied (follower $f)" ok || check "completed line is applied (follower $f)" failed
+done
+
+# Close every desk
+printf '10\n' >&3
+printf '10\n' >&4
+printf '10\n' >&5
+exec 3>&- 4>&- 5>&-
+wait
+
+if [ $failures -ne 0 ]; then
+    echo "$failures check(s) failed"
+    exit 1
+fi
+echo "All replication checks passed"